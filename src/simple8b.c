@@ -160,6 +160,102 @@ extern inline const int simple8bDecode(uint64_t* restrict dst, uint64_t v) {
     return selector[sel].n;
 }
 
+// simple8bCount() returns the number of values packed in the `wordsLen` words of `words`
+// without decoding them.
+const int simple8bCount(const uint64_t* restrict words, int wordsLen) {
+    int n = 0;
+    for (int i = 0; i < wordsLen; i++) {
+        n += selector[words[i] >> 60].n;
+    }
+    return n;
+}
+
+// simple8bConcat() writes the words of `a` followed by the words of `b` into `dst` and returns
+// the number of words written. Interior words are copied verbatim, only the last word of `a` and
+// the first word of `b` are re-encoded, when they fit in a single word. The result never exceeds
+// `aLen + bLen` words. It returns -1 when a length is negative or the result does not fit in
+// `dstCap` words.
+const int simple8bConcat(const uint64_t* restrict a, int aLen, const uint64_t* restrict b, int bLen,
+                         uint64_t* restrict dst, int dstCap) {
+    if (aLen < 0 || bLen < 0) {
+        return -1;
+    }
+
+    int from = 0;
+    uint64_t merged;
+    if (aLen > 0 && bLen > 0) {
+        // unpack120 writes 240 values, leave room for it after the first word
+        uint64_t boundary[480];
+        int m = simple8bDecode(boundary, a[aLen - 1]);
+        m += simple8bDecode(boundary + m, b[0]);
+        if (simple8bEncode(boundary, m, &merged) == m) {
+            from = 1;
+        }
+    }
+    if (aLen + bLen - from > dstCap) {
+        return -1;
+    }
+
+    for (int i = 0; i < aLen; i++) {
+        dst[i] = a[i];
+    }
+    int n = aLen;
+    if (from) {
+        dst[n - 1] = merged;
+    }
+    for (int i = from; i < bLen; i++) {
+        dst[n++] = b[i];
+    }
+    return n;
+}
+
+// simple8bSlice() writes the `len` values starting at value `start` of the encoded stream `words`
+// into `dst` as encoded words and returns the number of words written. Words fully inside the
+// range are copied verbatim, only the boundary words are re-encoded. The slice is truncated at the
+// end of the stream. The result never exceeds the number of spanned words plus 10. It returns -1
+// when `start` or `len` is negative or the result does not fit in `dstCap` words.
+const int simple8bSlice(const uint64_t* restrict words, int wordsLen, int start, int len,
+                        uint64_t* restrict dst, int dstCap) {
+    if (start < 0 || len < 0) {
+        return -1;
+    }
+
+    int i = 0;
+    int pos = 0;
+    while (i < wordsLen && pos + selector[words[i] >> 60].n <= start) {
+        pos += selector[words[i] >> 60].n;
+        i++;
+    }
+
+    uint64_t decoded[240];
+    int n = 0;
+    for (; len > 0 && i < wordsLen; i++) {
+        int count = selector[words[i] >> 60].n;
+        int skip = start > pos ? start - pos : 0;
+        int take = count - skip < len ? count - skip : len;
+
+        if (take == count) {
+            if (n == dstCap) {
+                return -1;
+            }
+            dst[n++] = words[i];
+        } else {
+            simple8bDecode(decoded, words[i]);
+            for (int k = 0; k < take;) {
+                if (n == dstCap) {
+                    return -1;
+                }
+                k += simple8bEncode(decoded + skip + k, take - k, dst + n);
+                n++;
+            }
+        }
+
+        len -= take;
+        pos += count;
+    }
+    return n;
+}
+
 static inline uint64_t pack240(const uint64_t* restrict src) {
     return 0;
 }
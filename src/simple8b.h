@@ -15,4 +15,24 @@ const int simple8bEncode(const uint64_t* restrict src, int srcLen, uint64_t* res
 
 // simple8bDecode() decodes a 64-bit number v, writes the result into a large enough list `dst`
 // and returns the number of unpacked values. The length of `dst` should be greater or equal to `240`
-const int simple8bDecode(uint64_t* restrict dst, uint64_t v);
\ No newline at end of file
+const int simple8bDecode(uint64_t* restrict dst, uint64_t v);
+
+// simple8bCount() returns the number of values packed in the `wordsLen` words of `words`
+// without decoding them.
+const int simple8bCount(const uint64_t* restrict words, int wordsLen);
+
+// simple8bConcat() writes the words of `a` followed by the words of `b` into `dst` and returns
+// the number of words written. Interior words are copied verbatim, only the last word of `a` and
+// the first word of `b` are re-encoded, when they fit in a single word. The result never exceeds
+// `aLen + bLen` words. It returns -1 when a length is negative or the result does not fit in
+// `dstCap` words.
+const int simple8bConcat(const uint64_t* restrict a, int aLen, const uint64_t* restrict b, int bLen,
+                         uint64_t* restrict dst, int dstCap);
+
+// simple8bSlice() writes the `len` values starting at value `start` of the encoded stream `words`
+// into `dst` as encoded words and returns the number of words written. Words fully inside the
+// range are copied verbatim, only the boundary words are re-encoded. The slice is truncated at the
+// end of the stream. The result never exceeds the number of spanned words plus 10. It returns -1
+// when `start` or `len` is negative or the result does not fit in `dstCap` words.
+const int simple8bSlice(const uint64_t* restrict words, int wordsLen, int start, int len,
+                        uint64_t* restrict dst, int dstCap);
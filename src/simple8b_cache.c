@@ -0,0 +1,304 @@
+#include "simple8b_cache.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simple8b.h"
+
+#define INITIAL_BUCKETS 16
+
+struct simple8bCacheEntry {
+    uint64_t key;
+    struct simple8bCacheEntry* chain;  // next entry in the same bucket
+    struct simple8bCacheEntry* prev;   // LRU neighbours
+    struct simple8bCacheEntry* next;
+    uint64_t* values;
+    uint64_t len;
+    uint64_t cap;
+    int wordsDone;  // number of leading words already decoded into `values`
+    int wordsLen;
+};
+
+static inline uint64_t hashKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline size_t entryBytes(const struct simple8bCacheEntry* e) {
+    return sizeof(*e) + sizeof(uint64_t) * e->cap;
+}
+
+// decodeWords decodes words of `e` until at least `maxValues` values are available
+// or the block is exhausted. It returns false when memory cannot be allocated.
+static bool decodeWords(struct simple8bCacheEntry* e, const uint64_t* words, uint64_t maxValues) {
+    while (e->len < maxValues && e->wordsDone < e->wordsLen) {
+        // simple8bDecode() may write up to 240 values.
+        if (e->cap - e->len < 240) {
+            uint64_t cap = e->cap << 1;
+            if (cap < e->len + 240) {
+                cap = e->len + 240;
+            }
+            uint64_t* values = realloc(e->values, sizeof(uint64_t) * cap);
+            if (!values) {
+                return false;
+            }
+            e->values = values;
+            e->cap = cap;
+        }
+        e->len += simple8bDecode(e->values + e->len, words[e->wordsDone++]);
+    }
+    return true;
+}
+
+static struct simple8bCacheEntry* find(struct simple8bCacheShard* s, uint64_t key, uint64_t hash) {
+    struct simple8bCacheEntry* e = s->buckets[hash & (s->bucketsLen - 1)];
+    while (e && e->key != key) {
+        e = e->chain;
+    }
+    return e;
+}
+
+static void moveToFront(struct simple8bCacheShard* s, struct simple8bCacheEntry* e) {
+    if (s->head == e) {
+        return;
+    }
+    // unlink
+    if (e->prev) {
+        e->prev->next = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    }
+    if (s->tail == e) {
+        s->tail = e->prev;
+    }
+    // push front
+    e->prev = NULL;
+    e->next = s->head;
+    if (s->head) {
+        s->head->prev = e;
+    }
+    s->head = e;
+    if (!s->tail) {
+        s->tail = e;
+    }
+}
+
+static void grow(struct simple8bCacheShard* s) {
+    uint64_t bucketsLen = s->bucketsLen << 1;
+    struct simple8bCacheEntry** buckets = calloc(bucketsLen, sizeof(*buckets));
+    if (!buckets) {
+        // keep the old table, chains just get longer
+        return;
+    }
+    for (uint64_t i = 0; i < s->bucketsLen; i++) {
+        struct simple8bCacheEntry* e = s->buckets[i];
+        while (e) {
+            struct simple8bCacheEntry* chain = e->chain;
+            uint64_t j = hashKey(e->key) & (bucketsLen - 1);
+            e->chain = buckets[j];
+            buckets[j] = e;
+            e = chain;
+        }
+    }
+    free(s->buckets);
+    s->buckets = buckets;
+    s->bucketsLen = bucketsLen;
+}
+
+static void insert(struct simple8bCacheShard* s, struct simple8bCacheEntry* e, uint64_t hash) {
+    if (s->entriesLen >= s->bucketsLen) {
+        grow(s);
+    }
+    uint64_t i = hash & (s->bucketsLen - 1);
+    e->chain = s->buckets[i];
+    s->buckets[i] = e;
+    e->prev = NULL;
+    e->next = NULL;
+    moveToFront(s, e);
+    s->entriesLen++;
+    s->bytes += entryBytes(e);
+}
+
+static void removeTail(struct simple8bCacheShard* s) {
+    struct simple8bCacheEntry* e = s->tail;
+    struct simple8bCacheEntry** p = &s->buckets[hashKey(e->key) & (s->bucketsLen - 1)];
+    while (*p != e) {
+        p = &(*p)->chain;
+    }
+    *p = e->chain;
+
+    s->tail = e->prev;
+    if (s->tail) {
+        s->tail->next = NULL;
+    } else {
+        s->head = NULL;
+    }
+    s->entriesLen--;
+    s->bytes -= entryBytes(e);
+    s->evictions++;
+    free(e->values);
+    free(e);
+}
+
+static void evict(struct simple8bCacheShard* s, size_t budget) {
+    while (s->bytes > budget && s->tail) {
+        removeTail(s);
+    }
+}
+
+static inline uint64_t copyPrefix(const struct simple8bCacheEntry* e, uint64_t* dst, uint64_t maxValues) {
+    uint64_t n = e->len < maxValues ? e->len : maxValues;
+    if (n == 0) {
+        return 0;
+    }
+    memcpy(dst, e->values, sizeof(uint64_t) * n);
+    return n;
+}
+
+// newEntry allocates an entry for `key`, starting from a copy of the values already
+// decoded in `prefix` when it is not NULL.
+static struct simple8bCacheEntry* newEntry(uint64_t key, int wordsLen, const struct simple8bCacheEntry* prefix) {
+    struct simple8bCacheEntry* e = calloc(1, sizeof(*e));
+    if (!e) {
+        return NULL;
+    }
+    e->key = key;
+    e->wordsLen = wordsLen;
+    if (prefix && prefix->len > 0) {
+        e->values = malloc(sizeof(uint64_t) * prefix->cap);
+        if (!e->values) {
+            free(e);
+            return NULL;
+        }
+        memcpy(e->values, prefix->values, sizeof(uint64_t) * prefix->len);
+        e->len = prefix->len;
+        e->cap = prefix->cap;
+        e->wordsDone = prefix->wordsDone;
+    }
+    return e;
+}
+
+bool simple8bCacheInit(struct simple8bCache* c, size_t budgetBytes, int shards) {
+    int n = 1;
+    while (n < shards && n < (1 << 16)) {
+        n <<= 1;
+    }
+    c->shards = calloc(n, sizeof(*c->shards));
+    if (!c->shards) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        struct simple8bCacheShard* s = &c->shards[i];
+        s->buckets = calloc(INITIAL_BUCKETS, sizeof(*s->buckets));
+        if (!s->buckets) {
+            c->shardsLen = i;
+            simple8bCacheFree(c);
+            return false;
+        }
+        s->bucketsLen = INITIAL_BUCKETS;
+        pthread_mutex_init(&s->mu, NULL);
+    }
+    c->shardsLen = n;
+    c->shardBudget = budgetBytes / n;
+    return true;
+}
+
+void simple8bCacheFree(struct simple8bCache* c) {
+    for (int i = 0; i < c->shardsLen; i++) {
+        struct simple8bCacheShard* s = &c->shards[i];
+        struct simple8bCacheEntry* e = s->head;
+        while (e) {
+            struct simple8bCacheEntry* next = e->next;
+            free(e->values);
+            free(e);
+            e = next;
+        }
+        free(s->buckets);
+        pthread_mutex_destroy(&s->mu);
+    }
+    free(c->shards);
+    c->shards = NULL;
+    c->shardsLen = 0;
+}
+
+uint64_t simple8bCacheRead(struct simple8bCache* c, uint64_t key, const uint64_t* words, int wordsLen,
+                           uint64_t* dst, uint64_t maxValues) {
+    uint64_t hash = hashKey(key);
+    struct simple8bCacheShard* s = &c->shards[(hash >> 48) & (c->shardsLen - 1)];
+
+    pthread_mutex_lock(&s->mu);
+    struct simple8bCacheEntry* e = find(s, key, hash);
+    if (e && (e->len >= maxValues || e->wordsDone == e->wordsLen)) {
+        s->hits++;
+        moveToFront(s, e);
+        uint64_t n = copyPrefix(e, dst, maxValues);
+        pthread_mutex_unlock(&s->mu);
+        return n;
+    }
+    // Either the block is missing or its cached prefix is too short. Decode without
+    // holding the lock, so that readers of other blocks in the same shard are not
+    // stalled, continuing from a copy of the cached prefix if there is one.
+    s->misses++;
+    struct simple8bCacheEntry* cached = e;
+    e = newEntry(key, wordsLen, cached);
+    if (!e) {
+        uint64_t n = cached ? copyPrefix(cached, dst, maxValues) : 0;
+        pthread_mutex_unlock(&s->mu);
+        return n;
+    }
+    pthread_mutex_unlock(&s->mu);
+
+    bool ok = decodeWords(e, words, maxValues);
+    uint64_t n = copyPrefix(e, dst, maxValues);
+    if (!ok || e->len == 0 || entryBytes(e) > c->shardBudget) {
+        free(e->values);
+        free(e);
+        return n;
+    }
+
+    pthread_mutex_lock(&s->mu);
+    struct simple8bCacheEntry* raced = find(s, key, hash);
+    if (raced) {
+        // The block was cached before or inserted by another reader meanwhile,
+        // keep the longer prefix.
+        if (raced->len < e->len) {
+            s->bytes -= entryBytes(raced);
+            uint64_t* values = raced->values;
+            raced->values = e->values;
+            raced->len = e->len;
+            raced->cap = e->cap;
+            raced->wordsDone = e->wordsDone;
+            e->values = values;
+            s->bytes += entryBytes(raced);
+        }
+        moveToFront(s, raced);
+        free(e->values);
+        free(e);
+    } else {
+        insert(s, e, hash);
+    }
+    evict(s, c->shardBudget);
+    pthread_mutex_unlock(&s->mu);
+    return n;
+}
+
+void simple8bCacheGetStats(struct simple8bCache* c, struct simple8bCacheStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < c->shardsLen; i++) {
+        struct simple8bCacheShard* s = &c->shards[i];
+        pthread_mutex_lock(&s->mu);
+        stats->hits += s->hits;
+        stats->misses += s->misses;
+        stats->evictions += s->evictions;
+        stats->bytes += s->bytes;
+        pthread_mutex_unlock(&s->mu);
+    }
+}
@@ -0,0 +1,57 @@
+// simple8b_cache.h implements an optional cache of decoded simple8b blocks.
+// Decoded values are kept under a byte budget and evicted in LRU order. The cache
+// is split into independently locked shards so that concurrent readers of
+// different blocks do not serialize on a single lock.
+
+#pragma once
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct simple8bCacheEntry;
+
+struct simple8bCacheShard {
+    pthread_mutex_t mu;
+    struct simple8bCacheEntry** buckets;
+    uint64_t bucketsLen;  // power of two
+    uint64_t entriesLen;
+    struct simple8bCacheEntry* head;  // most recently used
+    struct simple8bCacheEntry* tail;  // least recently used
+    size_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+struct simple8bCache {
+    struct simple8bCacheShard* shards;
+    int shardsLen;       // power of two
+    size_t shardBudget;  // bytes of decoded values each shard may hold
+};
+
+struct simple8bCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t bytes;
+};
+
+// `simple8bCacheInit()` creates a cache holding at most `budgetBytes` bytes of decoded values,
+// split over `shards` shards (rounded up to a power of two). It returns false when memory
+// cannot be allocated.
+bool simple8bCacheInit(struct simple8bCache* c, size_t budgetBytes, int shards);
+
+// `simple8bCacheFree()` releases every cached block.
+void simple8bCacheFree(struct simple8bCache* c);
+
+// `simple8bCacheRead()` copies up to `maxValues` leading values of the block identified by `key`
+// into `dst` and returns the number of values copied. `words` holds the `wordsLen` encoded words
+// of the block and is only decoded on a miss, or when the cached prefix is shorter than the
+// requested one. Only the words needed to cover `maxValues` values are decoded, so range reads
+// of a block prefix stay cheap. `key` must identify immutable block contents.
+uint64_t simple8bCacheRead(struct simple8bCache* c, uint64_t key, const uint64_t* words, int wordsLen,
+                           uint64_t* dst, uint64_t maxValues);
+
+// `simple8bCacheGetStats()` sums the counters of every shard into `stats`.
+void simple8bCacheGetStats(struct simple8bCache* c, struct simple8bCacheStats* stats);
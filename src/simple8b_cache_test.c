@@ -0,0 +1,165 @@
+#include "./simple8b_cache.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./simple8b.h"
+
+// encodeBlock encodes n values derived from `seed` and returns the number of words.
+int encodeBlock(uint64_t seed, int n, uint64_t* in, uint64_t* words) {
+    for (int i = 0; i < n; i++) {
+        in[i] = (seed * 31 + i) % 1000;
+    }
+    int wordsLen = 0;
+    for (int i = 0; i < n;) {
+        i += simple8bEncode(in + i, n - i, words + wordsLen);
+        wordsLen++;
+    }
+    return wordsLen;
+}
+
+void testCacheHitMiss() {
+    struct simple8bCache c;
+    assert(simple8bCacheInit(&c, 1 << 20, 4));
+    uint64_t in[1000], words[1000], out[1240];
+    int wordsLen = encodeBlock(7, 1000, in, words);
+
+    assert(simple8bCacheRead(&c, 7, words, wordsLen, out, 1000) == 1000);
+    assert(simple8bCacheRead(&c, 7, words, wordsLen, out, 1000) == 1000);
+    for (int i = 0; i < 1000; i++) {
+        assert(out[i] == in[i]);
+    }
+
+    struct simple8bCacheStats stats;
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits == 1 && stats.misses == 1 && stats.evictions == 0);
+    assert(stats.bytes > 0);
+    simple8bCacheFree(&c);
+}
+
+void testCachePrefix() {
+    struct simple8bCache c;
+    assert(simple8bCacheInit(&c, 1 << 20, 1));
+    uint64_t in[1000], words[1000], out[1240];
+    int wordsLen = encodeBlock(3, 1000, in, words);
+
+    // A short read decodes only the leading words.
+    assert(simple8bCacheRead(&c, 3, words, wordsLen, out, 10) == 10);
+    struct simple8bCacheStats stats;
+    simple8bCacheGetStats(&c, &stats);
+    size_t prefixBytes = stats.bytes;
+
+    assert(simple8bCacheRead(&c, 3, words, wordsLen, out, 5) == 5);
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits == 1 && stats.misses == 1);
+
+    // A longer read extends the cached prefix.
+    assert(simple8bCacheRead(&c, 3, words, wordsLen, out, 2000) == 1000);
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.misses == 2 && stats.bytes > prefixBytes);
+    for (int i = 0; i < 1000; i++) {
+        assert(out[i] == in[i]);
+    }
+    assert(simple8bCacheRead(&c, 3, words, wordsLen, out, 2000) == 1000);
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits == 2);
+    simple8bCacheFree(&c);
+}
+
+void testCacheEmpty() {
+    struct simple8bCache c;
+    assert(simple8bCacheInit(&c, 1 << 20, 1));
+    uint64_t in[100], words[100], out[340];
+    int wordsLen = encodeBlock(5, 100, in, words);
+
+    // Zero length probes and empty blocks copy nothing and take no cache slot.
+    assert(simple8bCacheRead(&c, 5, words, wordsLen, out, 0) == 0);
+    assert(simple8bCacheRead(&c, 6, words, 0, out, 100) == 0);
+    struct simple8bCacheStats stats;
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.misses == 2 && stats.bytes == 0);
+
+    assert(simple8bCacheRead(&c, 5, words, wordsLen, out, 100) == 100);
+    assert(simple8bCacheRead(&c, 5, words, wordsLen, out, 0) == 0);
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits == 1 && stats.misses == 3);
+    simple8bCacheFree(&c);
+}
+
+void testCacheEviction() {
+    struct simple8bCache c;
+    // Room for a handful of 1000 value blocks only.
+    assert(simple8bCacheInit(&c, 4 * 10000, 1));
+    uint64_t in[1000], words[1000], out[1240];
+
+    for (uint64_t key = 0; key < 50; key++) {
+        int wordsLen = encodeBlock(key, 1000, in, words);
+        assert(simple8bCacheRead(&c, key, words, wordsLen, out, 1000) == 1000);
+        for (int i = 0; i < 1000; i++) {
+            assert(out[i] == in[i]);
+        }
+    }
+    struct simple8bCacheStats stats;
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.bytes <= 4 * 10000);
+    assert(stats.evictions > 0);
+
+    // The most recent block survives, the oldest does not.
+    int wordsLen = encodeBlock(49, 1000, in, words);
+    simple8bCacheRead(&c, 49, words, wordsLen, out, 1000);
+    wordsLen = encodeBlock(0, 1000, in, words);
+    simple8bCacheRead(&c, 0, words, wordsLen, out, 1000);
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits == 1 && stats.misses == 51);
+    simple8bCacheFree(&c);
+}
+
+#define READERS 4
+
+void* readerRun(void* p) {
+    struct simple8bCache* c = p;
+    uint64_t in[1000], words[1000], out[1240];
+    for (int round = 0; round < 2000; round++) {
+        uint64_t key = round % 37;
+        int wordsLen = encodeBlock(key, 1000, in, words);
+        uint64_t n = simple8bCacheRead(c, key, words, wordsLen, out, 100 + round % 900);
+        assert(n == (uint64_t)(100 + round % 900));
+        for (uint64_t i = 0; i < n; i++) {
+            assert(out[i] == in[i]);
+        }
+    }
+    return NULL;
+}
+
+void testCacheConcurrent() {
+    struct simple8bCache c;
+    assert(simple8bCacheInit(&c, 1 << 18, 8));
+    pthread_t threads[READERS];
+    for (int i = 0; i < READERS; i++) {
+        assert(pthread_create(&threads[i], NULL, readerRun, &c) == 0);
+    }
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    struct simple8bCacheStats stats;
+    simple8bCacheGetStats(&c, &stats);
+    assert(stats.hits + stats.misses == READERS * 2000);
+    assert(stats.bytes <= 1 << 18);
+    simple8bCacheFree(&c);
+}
+
+int main() {
+    testCacheHitMiss();
+    printf("Pass testCacheHitMiss()\n");
+    testCachePrefix();
+    printf("Pass testCachePrefix()\n");
+    testCacheEmpty();
+    printf("Pass testCacheEmpty()\n");
+    testCacheEviction();
+    printf("Pass testCacheEviction()\n");
+    testCacheConcurrent();
+    printf("Pass testCacheConcurrent()\n");
+    return 0;
+}
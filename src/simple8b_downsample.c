@@ -0,0 +1,188 @@
+#include "simple8b_downsample.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "simple8b.h"
+
+#define PAYLOAD_MASK ((1ULL << 60) - 1)
+
+// values per word and bits per value, indexed by selector
+static const int selectorN[16] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+static const int selectorBits[16] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+
+// tsCursor walks the timestamp column one decoded word at a time.
+struct tsCursor {
+    const uint64_t* words;
+    int wordsLen;
+    int next;  // next word to decode
+    uint64_t buf[240];
+    int len;
+    int pos;
+};
+
+// valueCursor walks the value column without decoding it, values are read from
+// the packed word directly.
+struct valueCursor {
+    const uint64_t* words;
+    int wordsLen;
+    int next;  // next word to load
+    uint64_t word;
+    int n;
+    int pos;
+};
+
+static inline bool tsFill(struct tsCursor* c) {
+    while (c->pos == c->len) {
+        if (c->next == c->wordsLen) {
+            return false;
+        }
+        c->len = simple8bDecode(c->buf, c->words[c->next++]);
+        c->pos = 0;
+    }
+    return true;
+}
+
+// tsRun consumes the timestamps belonging to the bucket starting at `start`
+// and returns their number.
+static uint64_t tsRun(struct tsCursor* c, uint64_t start, uint64_t width) {
+    uint64_t run = 0;
+    while (tsFill(c)) {
+        // the whole remainder of the word falls in the bucket
+        if (c->buf[c->len - 1] - start < width) {
+            run += c->len - c->pos;
+            c->pos = c->len;
+            continue;
+        }
+        while (c->buf[c->pos] - start < width) {
+            c->pos++;
+            run++;
+        }
+        break;
+    }
+    return run;
+}
+
+static inline bool valueFill(struct valueCursor* c) {
+    if (c->pos < c->n) {
+        return true;
+    }
+    if (c->next == c->wordsLen) {
+        return false;
+    }
+    c->word = c->words[c->next++];
+    c->n = selectorN[c->word >> 60];
+    c->pos = 0;
+    return true;
+}
+
+static inline void add(struct simple8bBucket* b, uint64_t v) {
+    b->count++;
+    b->sum += v;
+    if (v < b->min) {
+        b->min = v;
+    }
+    if (v > b->max) {
+        b->max = v;
+    }
+}
+
+static inline void addRun(struct simple8bBucket* b, uint64_t n, uint64_t sum, uint64_t min, uint64_t max) {
+    b->count += n;
+    b->sum += sum;
+    if (min < b->min) {
+        b->min = min;
+    }
+    if (max > b->max) {
+        b->max = max;
+    }
+}
+
+// addWord aggregates every value packed in `w`.
+static void addWord(struct simple8bBucket* b, uint64_t w) {
+    int sel = w >> 60;
+    int n = selectorN[sel];
+    int bits = selectorBits[sel];
+    uint64_t payload = w & PAYLOAD_MASK;
+
+    if (bits == 0) {
+        // runs of ones
+        addRun(b, n, n, 1, 1);
+        return;
+    }
+    if (payload == 0) {
+        addRun(b, n, 0, 0, 0);
+        return;
+    }
+    if (bits == 1) {
+        uint64_t ones = __builtin_popcountll(payload);
+        addRun(b, n, ones, ones == (uint64_t)n ? 1 : 0, 1);
+        return;
+    }
+
+    uint64_t mask = (1ULL << bits) - 1;
+    uint64_t sum = 0;
+    uint64_t min = mask;
+    uint64_t max = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t v = (payload >> (i * bits)) & mask;
+        sum += v;
+        min = v < min ? v : min;
+        max = v > max ? v : max;
+    }
+    addRun(b, n, sum, min, max);
+}
+
+// aggregate adds the next `run` values of the column to `b`.
+static void aggregate(struct valueCursor* c, uint64_t run, struct simple8bBucket* b) {
+    while (run > 0 && valueFill(c)) {
+        if (c->pos == 0 && run >= (uint64_t)c->n) {
+            addWord(b, c->word);
+            run -= c->n;
+            c->pos = c->n;
+            continue;
+        }
+
+        int sel = c->word >> 60;
+        int bits = selectorBits[sel];
+        uint64_t left = (uint64_t)(c->n - c->pos);
+        uint64_t k = left < run ? left : run;
+        for (uint64_t i = 0; i < k; i++) {
+            uint64_t v = bits == 0 ? 1 : (c->word >> ((c->pos + i) * bits)) & ((1ULL << bits) - 1);
+            add(b, v);
+        }
+        c->pos += k;
+        run -= k;
+    }
+}
+
+int simple8bDownsample(const uint64_t* restrict ts, int tsLen, const uint64_t* restrict values, int valuesLen,
+                       uint64_t width, struct simple8bBucket* restrict out, int outCap) {
+    if (width == 0) {
+        return -1;
+    }
+    struct tsCursor tc = {.words = ts, .wordsLen = tsLen};
+    struct valueCursor vc = {.words = values, .wordsLen = valuesLen};
+
+    int n = 0;
+    while (tsFill(&tc)) {
+        uint64_t t = tc.buf[tc.pos];
+        uint64_t start = t - t % width;
+        uint64_t run = tsRun(&tc, start, width);
+
+        struct simple8bBucket b = {start, 0, 0, UINT64_MAX, 0};
+        aggregate(&vc, run, &b);
+        if (b.count == 0) {
+            // the value column is exhausted
+            break;
+        }
+        if (n == outCap) {
+            return -1;
+        }
+        out[n++] = b;
+        if (b.count < run) {
+            break;
+        }
+    }
+    return n;
+}
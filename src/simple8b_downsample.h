@@ -0,0 +1,22 @@
+// simple8b_downsample.h aggregates a simple8b encoded value column into fixed width
+// time buckets, driven by a simple8b encoded timestamp column. Both columns are read
+// word by word in lockstep, so neither of them is decoded into a full array first.
+
+#pragma once
+#include <stdint.h>
+
+struct simple8bBucket {
+    uint64_t start;  // first timestamp covered by the bucket, a multiple of the width
+    uint64_t count;
+    uint64_t sum;  // wraps around on overflow
+    uint64_t min;
+    uint64_t max;
+};
+
+// `simple8bDownsample()` groups the values of `values` by the bucket `[k * width, (k + 1) * width)`
+// holding their timestamp in `ts`, writes one bucket per non-empty group into `out` and returns
+// the number of buckets written. Timestamps must be in ascending order. The i-th value belongs to
+// the i-th timestamp and aggregation stops at the end of the shorter column. It returns -1 when
+// `width` is 0 or when the buckets do not fit in `outCap` entries.
+int simple8bDownsample(const uint64_t* restrict ts, int tsLen, const uint64_t* restrict values, int valuesLen,
+                       uint64_t width, struct simple8bBucket* restrict out, int outCap);
@@ -0,0 +1,120 @@
+#include "./simple8b_downsample.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./simple8b.h"
+
+// encodeAll encodes n values of `in` into `encoded` and returns the number of words.
+int encodeAll(const uint64_t* in, int n, uint64_t* encoded) {
+    int encodedLen = 0;
+    for (int i = 0; i < n;) {
+        i += simple8bEncode(in + i, n - i, encoded + encodedLen);
+        encodedLen++;
+    }
+    return encodedLen;
+}
+
+// naive aggregates the decoded columns directly.
+int naive(const uint64_t* ts, const uint64_t* values, int n, uint64_t width, struct simple8bBucket* out) {
+    int k = -1;
+    for (int i = 0; i < n; i++) {
+        uint64_t start = ts[i] - ts[i] % width;
+        if (k < 0 || out[k].start != start) {
+            k++;
+            out[k] = (struct simple8bBucket){start, 0, 0, UINT64_MAX, 0};
+        }
+        out[k].count++;
+        out[k].sum += values[i];
+        out[k].min = values[i] < out[k].min ? values[i] : out[k].min;
+        out[k].max = values[i] > out[k].max ? values[i] : out[k].max;
+    }
+    return k + 1;
+}
+
+void testDownsample(int n, uint64_t width, int kind) {
+    uint64_t* ts = malloc(sizeof(uint64_t) * n);
+    uint64_t* values = malloc(sizeof(uint64_t) * n);
+    uint64_t* tsWords = malloc(sizeof(uint64_t) * n);
+    uint64_t* valueWords = malloc(sizeof(uint64_t) * n);
+    struct simple8bBucket* got = malloc(sizeof(*got) * n);
+    struct simple8bBucket* want = malloc(sizeof(*want) * n);
+    assert(ts && values && tsWords && valueWords && got && want);
+
+    uint64_t t = 1700000000;
+    for (int i = 0; i < n; i++) {
+        // mostly regular steps with occasional gaps
+        t += i % 97 == 0 ? 50 : 1 + i % 3;
+        ts[i] = t;
+        switch (kind) {
+            case 0:  // runs of ones and zeros, then 1 bit values
+                values[i] = (i / 400) % 3 == 0 ? 1 : (i / 400) % 3 == 1 ? 0 : (i * 7) % 2;
+                break;
+            case 1:  // small values
+                values[i] = (i * 31) % 13;
+                break;
+            default:  // wide values
+                values[i] = ((uint64_t)i * 2654435761ULL) % (1ULL << 40);
+        }
+    }
+    int tsLen = encodeAll(ts, n, tsWords);
+    int valuesLen = encodeAll(values, n, valueWords);
+
+    int m = simple8bDownsample(tsWords, tsLen, valueWords, valuesLen, width, got, n);
+    int w = naive(ts, values, n, width, want);
+    assert(m == w);
+    for (int i = 0; i < m; i++) {
+        assert(got[i].start == want[i].start);
+        assert(got[i].count == want[i].count);
+        assert(got[i].sum == want[i].sum);
+        assert(got[i].min == want[i].min);
+        assert(got[i].max == want[i].max);
+    }
+    if (m > 1) {
+        assert(simple8bDownsample(tsWords, tsLen, valueWords, valuesLen, width, got, m - 1) == -1);
+    }
+
+    free(ts);
+    free(values);
+    free(tsWords);
+    free(valueWords);
+    free(got);
+    free(want);
+}
+
+void testDownsampleShorterValues() {
+    uint64_t ts[500], values[300], tsWords[500], valueWords[300];
+    for (int i = 0; i < 500; i++) {
+        ts[i] = 1000 + i;
+    }
+    for (int i = 0; i < 300; i++) {
+        values[i] = i;
+    }
+    int tsLen = encodeAll(ts, 500, tsWords);
+    int valuesLen = encodeAll(values, 300, valueWords);
+
+    struct simple8bBucket out[10];
+    assert(simple8bDownsample(tsWords, tsLen, valueWords, valuesLen, 100, out, 10) == 3);
+    assert(out[0].start == 1000 && out[0].count == 100);
+    assert(out[2].start == 1200 && out[2].count == 100 && out[2].max == 299);
+    assert(simple8bDownsample(tsWords, tsLen, valueWords, valuesLen, 0, out, 10) == -1);
+}
+
+int main() {
+    testDownsample(10000, 60, 0);
+    printf("Pass testDownsample(10000, 60, 0)\n");
+    testDownsample(10000, 1000, 0);
+    printf("Pass testDownsample(10000, 1000, 0)\n");
+    testDownsample(10000, 7, 1);
+    printf("Pass testDownsample(10000, 7, 1)\n");
+    testDownsample(10000, 3600, 1);
+    printf("Pass testDownsample(10000, 3600, 1)\n");
+    testDownsample(10000, 10, 2);
+    printf("Pass testDownsample(10000, 10, 2)\n");
+    testDownsample(10000, 1, 2);
+    printf("Pass testDownsample(10000, 1, 2)\n");
+    testDownsampleShorterValues();
+    printf("Pass testDownsampleShorterValues()\n");
+    return 0;
+}
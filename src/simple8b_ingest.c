@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+#include "simple8b_ingest.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "simple8b.h"
+
+#define MAX_VALUE ((1ULL << 60) - 1)
+#define MAX_CAPACITY (1ULL << 30)
+
+bool simple8bSeriesInit(struct simple8bSeries* s, uint64_t capacity) {
+    if (capacity == 0 || capacity > MAX_CAPACITY) {
+        return false;
+    }
+    uint64_t c = 1;
+    while (c < capacity) {
+        c <<= 1;
+    }
+
+    s->slots = calloc(c, sizeof(*s->slots));
+    s->seqs = calloc(c, sizeof(*s->seqs));
+    s->scratch = malloc(sizeof(uint64_t) * c);
+    // Every word holds at least one value, so `c` words are always enough.
+    s->packed = malloc(sizeof(uint64_t) * c);
+    if (!s->slots || !s->seqs || !s->scratch || !s->packed) {
+        free(s->slots);
+        free(s->seqs);
+        free(s->scratch);
+        free(s->packed);
+        return false;
+    }
+
+    s->capacity = c;
+    atomic_init(&s->tail, 0);
+    atomic_init(&s->head, 0);
+    atomic_init(&s->first, NULL);
+    s->last = NULL;
+    return true;
+}
+
+void simple8bSeriesFree(struct simple8bSeries* s) {
+    struct simple8bChunk* c = atomic_load_explicit(&s->first, memory_order_relaxed);
+    while (c) {
+        struct simple8bChunk* next = atomic_load_explicit(&c->next, memory_order_relaxed);
+        free(c);
+        c = next;
+    }
+    free(s->slots);
+    free(s->seqs);
+    free(s->scratch);
+    free(s->packed);
+}
+
+bool simple8bSeriesAppend(struct simple8bSeries* s, uint64_t v) {
+    if (v > MAX_VALUE) {
+        return false;
+    }
+
+    // Reserve a position. The acquire load of `head` orders our slot write after the
+    // sealer has finished reading the previous value stored in the same slot.
+    uint64_t pos = atomic_load_explicit(&s->tail, memory_order_relaxed);
+    do {
+        if (pos - atomic_load_explicit(&s->head, memory_order_acquire) >= s->capacity) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&s->tail, &pos, pos + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    // Pairs with the acquire fence in simple8bSeriesSnapshot(): a reader that copies
+    // this value must then observe the head that allowed the slot to be reused.
+    atomic_thread_fence(memory_order_release);
+
+    uint64_t i = pos & (s->capacity - 1);
+    atomic_store_explicit(&s->slots[i], v, memory_order_relaxed);
+    atomic_store_explicit(&s->seqs[i], pos + 1, memory_order_release);
+    return true;
+}
+
+// collectPending copies the contiguous run of published values starting at `head`
+// into `dst` and returns its length.
+static uint64_t collectPending(struct simple8bSeries* s, uint64_t head, uint64_t* restrict dst) {
+    uint64_t mask = s->capacity - 1;
+    uint64_t n = 0;
+    while (n < s->capacity) {
+        uint64_t pos = head + n;
+        if (atomic_load_explicit(&s->seqs[pos & mask], memory_order_acquire) != pos + 1) {
+            break;
+        }
+        dst[n] = atomic_load_explicit(&s->slots[pos & mask], memory_order_relaxed);
+        n++;
+    }
+    return n;
+}
+
+uint64_t simple8bSeriesSeal(struct simple8bSeries* s, uint64_t minValues, bool flush) {
+    uint64_t head = atomic_load_explicit(&s->head, memory_order_relaxed);
+    uint64_t n = collectPending(s, head, s->scratch);
+    if (n == 0 || n < minValues) {
+        return 0;
+    }
+
+    uint64_t len = 0;
+    int wordsLen = 0;
+    while (len < n) {
+        // No word holds more than 240 values, and simple8bEncode() scans its whole
+        // input for runs of ones, so never hand it more than one word's worth.
+        uint64_t left = n - len < 240 ? n - len : 240;
+        int m = simple8bEncode(s->scratch + len, (int)left, s->packed + wordsLen);
+        // A word that consumed every remaining value may have picked a wider selector
+        // only because it ran short of input, so keep those values pending. A full ring
+        // cannot receive more values, so its trailing word is sealed regardless.
+        if (!flush && len + m == n && n < s->capacity) {
+            break;
+        }
+        len += m;
+        wordsLen++;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    struct simple8bChunk* c = malloc(sizeof(*c) + sizeof(uint64_t) * wordsLen);
+    if (!c) {
+        return 0;
+    }
+    atomic_init(&c->next, NULL);
+    c->len = len;
+    c->wordsLen = wordsLen;
+    for (int i = 0; i < wordsLen; i++) {
+        c->words[i] = s->packed[i];
+    }
+
+    // Publish the chunk before advancing `head`, so that a reader observing the new
+    // head always finds the chunks covering it.
+    if (s->last) {
+        atomic_store_explicit(&s->last->next, c, memory_order_release);
+    } else {
+        atomic_store_explicit(&s->first, c, memory_order_release);
+    }
+    s->last = c;
+    atomic_store_explicit(&s->head, head + len, memory_order_release);
+    return len;
+}
+
+void simple8bSeriesSnapshot(struct simple8bSeries* s, struct simple8bSnapshot* snap) {
+    uint64_t head;
+    uint64_t n;
+    for (;;) {
+        head = atomic_load_explicit(&s->head, memory_order_acquire);
+        n = collectPending(s, head, snap->tail);
+        // Slots are only reused once `head` moves past them, so an unchanged head
+        // means every copied value belongs to this snapshot.
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&s->head, memory_order_relaxed) == head) {
+            break;
+        }
+    }
+    snap->chunks = atomic_load_explicit(&s->first, memory_order_acquire);
+    snap->sealedLen = head;
+    snap->tailLen = n;
+}
+
+static void* sealerRun(void* arg) {
+    struct simple8bSealer* sealer = arg;
+    struct timespec interval = {
+        .tv_sec = sealer->intervalMicros / 1000000,
+        .tv_nsec = (long)(sealer->intervalMicros % 1000000) * 1000,
+    };
+    while (!atomic_load_explicit(&sealer->stop, memory_order_acquire)) {
+        for (int i = 0; i < sealer->seriesLen; i++) {
+            simple8bSeriesSeal(sealer->series[i], sealer->minValues, false);
+        }
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}
+
+bool simple8bSealerStart(struct simple8bSealer* sealer, struct simple8bSeries** series, int seriesLen,
+                         uint64_t minValues, unsigned intervalMicros) {
+    // a series whose ring cannot hold `minValues` values would never be sealed
+    for (int i = 0; i < seriesLen; i++) {
+        if (minValues > series[i]->capacity) {
+            return false;
+        }
+    }
+    sealer->series = series;
+    sealer->seriesLen = seriesLen;
+    sealer->minValues = minValues;
+    sealer->intervalMicros = intervalMicros;
+    atomic_init(&sealer->stop, false);
+    return pthread_create(&sealer->thread, NULL, sealerRun, sealer) == 0;
+}
+
+void simple8bSealerStop(struct simple8bSealer* sealer) {
+    atomic_store_explicit(&sealer->stop, true, memory_order_release);
+    pthread_join(sealer->thread, NULL);
+    for (int i = 0; i < sealer->seriesLen; i++) {
+        simple8bSeriesSeal(sealer->series[i], 0, true);
+    }
+}
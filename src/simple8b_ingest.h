@@ -0,0 +1,84 @@
+// simple8b_ingest.h implements a concurrent ingest buffer on top of simple8b.h.
+// Many writer threads append values to a series through a lock-free pending ring,
+// while a single sealer packs the published values into immutable chunks of
+// simple8b words. Readers take a consistent snapshot of the sealed chunks plus
+// the values that are still pending, without blocking writers or the sealer.
+
+#pragma once
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// An immutable run of simple8b words produced by one seal. Chunks are linked in
+// append order and stay valid until `simple8bSeriesFree()`.
+struct simple8bChunk {
+    _Atomic(struct simple8bChunk*) next;
+    uint64_t len;   // number of values encoded in `words`
+    int wordsLen;   // number of words
+    uint64_t words[];
+};
+
+struct simple8bSeries {
+    _Atomic uint64_t* slots;  // pending values, indexed by position & (capacity - 1)
+    _Atomic uint64_t* seqs;   // position + 1 once the slot's value is published
+    uint64_t capacity;        // power of two
+    _Atomic uint64_t tail;    // next position handed to a writer
+    _Atomic uint64_t head;    // first position that is not sealed yet
+    _Atomic(struct simple8bChunk*) first;
+    struct simple8bChunk* last;  // owned by the sealer
+    uint64_t* scratch;           // owned by the sealer
+    uint64_t* packed;            // owned by the sealer
+};
+
+// A view returned by `simple8bSeriesSnapshot()`. The first `sealedLen` values are
+// found by walking `chunks`, the next `tailLen` values are copied into `tail`.
+struct simple8bSnapshot {
+    const struct simple8bChunk* chunks;
+    uint64_t sealedLen;
+    uint64_t tailLen;
+    uint64_t* tail;  // caller provided, at least `capacity` values long
+};
+
+// `simple8bSeriesInit()` prepares an empty series whose pending ring holds at least
+// `capacity` values. It returns false when memory cannot be allocated.
+bool simple8bSeriesInit(struct simple8bSeries* s, uint64_t capacity);
+
+// `simple8bSeriesFree()` releases the ring and every sealed chunk. No other thread may
+// use the series or a snapshot of it afterwards.
+void simple8bSeriesFree(struct simple8bSeries* s);
+
+// `simple8bSeriesAppend()` publishes `v` at the end of the series. It is safe to call
+// from any number of threads and never blocks. It returns false when `v` does not fit
+// in 60 bits or when the pending ring is full, in which case the caller should retry
+// once the sealer has caught up.
+bool simple8bSeriesAppend(struct simple8bSeries* s, uint64_t v);
+
+// `simple8bSeriesSeal()` packs the published pending values into a new chunk and returns
+// the number of values sealed. Nothing is sealed while fewer than `minValues` values are
+// pending. Unless `flush` is set, the values of a trailing word that may still be
+// densified by later appends stay pending. Only one thread may seal a series at a time.
+uint64_t simple8bSeriesSeal(struct simple8bSeries* s, uint64_t minValues, bool flush);
+
+// `simple8bSeriesSnapshot()` fills `snap` with a consistent view of the series. It is
+// safe to call concurrently with writers and the sealer.
+void simple8bSeriesSnapshot(struct simple8bSeries* s, struct simple8bSnapshot* snap);
+
+// A background thread that periodically seals a fixed set of series.
+struct simple8bSealer {
+    pthread_t thread;
+    struct simple8bSeries** series;
+    int seriesLen;
+    uint64_t minValues;
+    unsigned intervalMicros;
+    atomic_bool stop;
+};
+
+// `simple8bSealerStart()` starts sealing `series` every `intervalMicros` microseconds.
+// It returns false when `minValues` exceeds the capacity of a series or when the thread
+// cannot be created.
+bool simple8bSealerStart(struct simple8bSealer* sealer, struct simple8bSeries** series, int seriesLen,
+                         uint64_t minValues, unsigned intervalMicros);
+
+// `simple8bSealerStop()` stops the thread and flushes every series one last time.
+void simple8bSealerStop(struct simple8bSealer* sealer);
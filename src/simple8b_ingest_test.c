@@ -0,0 +1,221 @@
+#include "./simple8b_ingest.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "./simple8b.h"
+
+// collect decodes the sealed part of a snapshot followed by its tail into `dst`
+// and returns the number of values.
+uint64_t collect(struct simple8bSnapshot* snap, uint64_t* dst) {
+    uint64_t decoded[240];
+    uint64_t k = 0;
+    for (const struct simple8bChunk* c = snap->chunks; c && k < snap->sealedLen; c = c->next) {
+        uint64_t before = k;
+        for (int i = 0; i < c->wordsLen; i++) {
+            int unpacked = simple8bDecode(decoded, c->words[i]);
+            for (int j = 0; j < unpacked && k - before < c->len; j++) {
+                dst[k++] = decoded[j];
+            }
+        }
+    }
+    assert(k == snap->sealedLen);
+    for (uint64_t i = 0; i < snap->tailLen; i++) {
+        dst[k++] = snap->tail[i];
+    }
+    return k;
+}
+
+void testSeriesOrder() {
+    struct simple8bSeries s;
+    assert(simple8bSeriesInit(&s, 500));
+    uint64_t* tail = malloc(sizeof(uint64_t) * s.capacity);
+    uint64_t* out = malloc(sizeof(uint64_t) * 1000);
+
+    for (uint64_t i = 0; i < 300; i++) {
+        assert(simple8bSeriesAppend(&s, i % 17));
+    }
+    assert(!simple8bSeriesAppend(&s, 1ULL << 60));
+    assert(simple8bSeriesSeal(&s, 1000, false) == 0);
+    uint64_t sealed = simple8bSeriesSeal(&s, 0, false);
+    assert(sealed > 0 && sealed < 300);
+    for (uint64_t i = 300; i < 600; i++) {
+        assert(simple8bSeriesAppend(&s, i % 17));
+    }
+
+    struct simple8bSnapshot snap = {.tail = tail};
+    simple8bSeriesSnapshot(&s, &snap);
+    assert(snap.sealedLen == sealed);
+    assert(collect(&snap, out) == 600);
+    for (uint64_t i = 0; i < 600; i++) {
+        assert(out[i] == i % 17);
+    }
+
+    assert(simple8bSeriesSeal(&s, 0, true) == 600 - sealed);
+    simple8bSeriesSnapshot(&s, &snap);
+    assert(snap.sealedLen == 600 && snap.tailLen == 0);
+    assert(collect(&snap, out) == 600);
+    for (uint64_t i = 0; i < 600; i++) {
+        assert(out[i] == i % 17);
+    }
+
+    free(tail);
+    free(out);
+    simple8bSeriesFree(&s);
+}
+
+void testSeriesFull() {
+    struct simple8bSeries s;
+    assert(simple8bSeriesInit(&s, 8));
+    for (int i = 0; i < 8; i++) {
+        assert(simple8bSeriesAppend(&s, 5));
+    }
+    assert(!simple8bSeriesAppend(&s, 5));
+    assert(simple8bSeriesSeal(&s, 0, true) == 8);
+    assert(simple8bSeriesAppend(&s, 5));
+    simple8bSeriesFree(&s);
+}
+
+void testSeriesSmallRingSealer() {
+    for (uint64_t capacity = 1; capacity <= 8; capacity <<= 1) {
+        struct simple8bSeries s;
+        assert(simple8bSeriesInit(&s, capacity));
+        // A full ring whose values fit in one word is sealed without flushing.
+        for (uint64_t i = 0; i < capacity; i++) {
+            assert(simple8bSeriesAppend(&s, 5));
+        }
+        assert(simple8bSeriesSeal(&s, 0, false) == capacity);
+
+        struct simple8bSeries* all[] = {&s};
+        struct simple8bSealer sealer;
+        assert(!simple8bSealerStart(&sealer, all, 1, capacity + 1, 10));
+        assert(simple8bSealerStart(&sealer, all, 1, capacity, 10));
+        for (int i = 0; i < 1000; i++) {
+            while (!simple8bSeriesAppend(&s, 5)) {
+            }
+        }
+        simple8bSealerStop(&sealer);
+
+        uint64_t* tail = malloc(sizeof(uint64_t) * s.capacity);
+        uint64_t* out = malloc(sizeof(uint64_t) * (1000 + capacity));
+        struct simple8bSnapshot snap = {.tail = tail};
+        simple8bSeriesSnapshot(&s, &snap);
+        assert(snap.tailLen == 0);
+        assert(collect(&snap, out) == 1000 + capacity);
+        free(tail);
+        free(out);
+        simple8bSeriesFree(&s);
+    }
+}
+
+void testSeriesSealOnesFast() {
+    struct simple8bSeries s;
+    assert(simple8bSeriesInit(&s, 1 << 20));
+    for (int i = 0; i < 1 << 20; i++) {
+        assert(simple8bSeriesAppend(&s, 1));
+    }
+    clock_t begin = clock();
+    assert(simple8bSeriesSeal(&s, 0, true) == 1 << 20);
+    double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    // a linear seal takes milliseconds, rescanning the ring per word takes seconds
+    assert(elapsed < 0.25);
+
+    uint64_t* tail = malloc(sizeof(uint64_t) * s.capacity);
+    uint64_t* out = malloc(sizeof(uint64_t) * (1 << 20));
+    struct simple8bSnapshot snap = {.tail = tail};
+    simple8bSeriesSnapshot(&s, &snap);
+    assert(collect(&snap, out) == 1 << 20);
+    for (int i = 0; i < 1 << 20; i++) {
+        assert(out[i] == 1);
+    }
+    free(tail);
+    free(out);
+    simple8bSeriesFree(&s);
+}
+
+#define WRITERS 4
+#define PER_WRITER 100000
+
+struct writerArg {
+    struct simple8bSeries* s;
+    uint64_t id;
+};
+
+void* writerRun(void* p) {
+    struct writerArg* a = p;
+    for (uint64_t i = 0; i < PER_WRITER; i++) {
+        // Writer id in the high bits, sequence in the low bits.
+        uint64_t v = a->id << 32 | i;
+        while (!simple8bSeriesAppend(a->s, v)) {
+        }
+    }
+    return NULL;
+}
+
+void testSeriesConcurrent() {
+    struct simple8bSeries s;
+    assert(simple8bSeriesInit(&s, 1024));
+    struct simple8bSeries* all[] = {&s};
+    struct simple8bSealer sealer;
+    assert(simple8bSealerStart(&sealer, all, 1, 64, 50));
+
+    pthread_t threads[WRITERS];
+    struct writerArg args[WRITERS];
+    for (int i = 0; i < WRITERS; i++) {
+        args[i] = (struct writerArg){&s, i};
+        assert(pthread_create(&threads[i], NULL, writerRun, &args[i]) == 0);
+    }
+
+    // Snapshots taken while writing must preserve each writer's order.
+    uint64_t* tail = malloc(sizeof(uint64_t) * s.capacity);
+    uint64_t* out = malloc(sizeof(uint64_t) * WRITERS * PER_WRITER);
+    for (int round = 0; round < 20; round++) {
+        struct simple8bSnapshot snap = {.tail = tail};
+        simple8bSeriesSnapshot(&s, &snap);
+        uint64_t n = collect(&snap, out);
+        uint64_t next[WRITERS] = {0};
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t id = out[i] >> 32;
+            assert(id < WRITERS);
+            assert((out[i] & 0xffffffff) == next[id]);
+            next[id]++;
+        }
+    }
+
+    for (int i = 0; i < WRITERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    simple8bSealerStop(&sealer);
+
+    struct simple8bSnapshot snap = {.tail = tail};
+    simple8bSeriesSnapshot(&s, &snap);
+    assert(snap.tailLen == 0);
+    assert(collect(&snap, out) == WRITERS * PER_WRITER);
+    uint64_t next[WRITERS] = {0};
+    for (uint64_t i = 0; i < WRITERS * PER_WRITER; i++) {
+        uint64_t id = out[i] >> 32;
+        assert((out[i] & 0xffffffff) == next[id]);
+        next[id]++;
+    }
+
+    free(tail);
+    free(out);
+    simple8bSeriesFree(&s);
+}
+
+int main() {
+    testSeriesOrder();
+    printf("Pass testSeriesOrder()\n");
+    testSeriesFull();
+    printf("Pass testSeriesFull()\n");
+    testSeriesSmallRingSealer();
+    printf("Pass testSeriesSmallRingSealer()\n");
+    testSeriesSealOnesFast();
+    printf("Pass testSeriesSealOnesFast()\n");
+    testSeriesConcurrent();
+    printf("Pass testSeriesConcurrent()\n");
+    return 0;
+}
@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+#include "simple8b_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "simple8b.h"
+
+#define BUFFER_ALIGN 4096
+
+static void* readerRun(void* arg) {
+    struct simple8bReader* r = arg;
+    off_t chunkBytes = (off_t)r->chunkWords * sizeof(uint64_t);
+
+    for (;;) {
+        pthread_mutex_lock(&r->mu);
+        // backpressure: wait until the caller releases a buffer
+        while (r->filled == r->buffersLen && !r->stop) {
+            pthread_cond_wait(&r->notFull, &r->mu);
+        }
+        if (r->stop || r->offset >= r->end) {
+            r->done = true;
+            pthread_cond_broadcast(&r->notEmpty);
+            pthread_mutex_unlock(&r->mu);
+            return NULL;
+        }
+        int idx = r->writeIdx;
+        pthread_mutex_unlock(&r->mu);
+
+        off_t off = r->offset;
+        size_t bytes = r->end - off < chunkBytes ? r->end - off : chunkBytes;
+        // Let the kernel start fetching what the following reads will ask for.
+        off_t ahead = off + bytes;
+        if (ahead < r->end) {
+            off_t aheadBytes = chunkBytes * r->buffersLen;
+            if (r->end - ahead < aheadBytes) {
+                aheadBytes = r->end - ahead;
+            }
+            posix_fadvise(r->fd, ahead, aheadBytes, POSIX_FADV_WILLNEED);
+        }
+
+        char* buf = (char*)r->buffers[idx];
+        size_t got = 0;
+        int err = 0;
+        while (got < bytes) {
+            ssize_t k = pread(r->fd, buf + got, bytes - got, off + got);
+            if (k < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                err = errno;
+                break;
+            }
+            if (k == 0) {
+                // the file is shorter than announced
+                err = EIO;
+                break;
+            }
+            got += k;
+        }
+
+        pthread_mutex_lock(&r->mu);
+        if (err) {
+            r->err = err;
+            r->done = true;
+            pthread_cond_broadcast(&r->notEmpty);
+            pthread_mutex_unlock(&r->mu);
+            return NULL;
+        }
+        r->lens[idx] = bytes / sizeof(uint64_t);
+        r->writeIdx = (idx + 1) % r->buffersLen;
+        r->filled++;
+        r->offset = off + bytes;
+        pthread_cond_signal(&r->notEmpty);
+        pthread_mutex_unlock(&r->mu);
+    }
+}
+
+// release frees the buffers and synchronization objects of `r`.
+static void release(struct simple8bReader* r) {
+    if (r->buffers) {
+        for (int i = 0; i < r->buffersLen; i++) {
+            free(r->buffers[i]);
+        }
+    }
+    free(r->buffers);
+    free(r->lens);
+    pthread_mutex_destroy(&r->mu);
+    pthread_cond_destroy(&r->notEmpty);
+    pthread_cond_destroy(&r->notFull);
+}
+
+bool simple8bReaderOpen(struct simple8bReader* r, int fd, off_t offset, uint64_t wordsLen, int chunkWords,
+                        int buffersLen) {
+    if (chunkWords <= 0 || buffersLen <= 0) {
+        return false;
+    }
+    memset(r, 0, sizeof(*r));
+    pthread_mutex_init(&r->mu, NULL);
+    pthread_cond_init(&r->notEmpty, NULL);
+    pthread_cond_init(&r->notFull, NULL);
+    r->fd = fd;
+    r->offset = offset;
+    r->end = offset + (off_t)(wordsLen * sizeof(uint64_t));
+    r->chunkWords = chunkWords;
+    r->buffersLen = buffersLen;
+
+    r->buffers = calloc(buffersLen, sizeof(*r->buffers));
+    r->lens = calloc(buffersLen, sizeof(*r->lens));
+    if (!r->buffers || !r->lens) {
+        release(r);
+        return false;
+    }
+    size_t bytes = (chunkWords * sizeof(uint64_t) + BUFFER_ALIGN - 1) / BUFFER_ALIGN * BUFFER_ALIGN;
+    for (int i = 0; i < buffersLen; i++) {
+        r->buffers[i] = aligned_alloc(BUFFER_ALIGN, bytes);
+        if (!r->buffers[i]) {
+            release(r);
+            return false;
+        }
+    }
+
+    if (r->end > offset) {
+        posix_fadvise(fd, offset, r->end - offset, POSIX_FADV_SEQUENTIAL);
+    }
+    if (pthread_create(&r->thread, NULL, readerRun, r) != 0) {
+        release(r);
+        return false;
+    }
+    return true;
+}
+
+// drainPending copies values left over from a previous word into `dst`.
+static inline int drainPending(struct simple8bReader* r, uint64_t* restrict dst, int dstCap) {
+    int n = r->pendingLen - r->pendingPos;
+    if (n > dstCap) {
+        n = dstCap;
+    }
+    memcpy(dst, r->pending + r->pendingPos, sizeof(uint64_t) * n);
+    r->pendingPos += n;
+    return n;
+}
+
+int simple8bReaderNext(struct simple8bReader* r, uint64_t* restrict dst, int dstCap) {
+    int n = drainPending(r, dst, dstCap);
+    while (n < dstCap) {
+        pthread_mutex_lock(&r->mu);
+        while (r->filled == 0 && !r->done) {
+            pthread_cond_wait(&r->notEmpty, &r->mu);
+        }
+        if (r->filled == 0) {
+            int err = r->err;
+            pthread_mutex_unlock(&r->mu);
+            // report a failed read once the values decoded so far are returned
+            return err && n == 0 ? -1 : n;
+        }
+        const uint64_t* words = r->buffers[r->readIdx];
+        int len = r->lens[r->readIdx];
+        pthread_mutex_unlock(&r->mu);
+
+        while (r->wordPos < len && n < dstCap) {
+            // simple8bDecode() may write up to 240 values
+            if (dstCap - n >= 240) {
+                n += simple8bDecode(dst + n, words[r->wordPos++]);
+            } else {
+                r->pendingLen = simple8bDecode(r->pending, words[r->wordPos++]);
+                r->pendingPos = 0;
+                n += drainPending(r, dst + n, dstCap - n);
+            }
+        }
+
+        if (r->wordPos == len) {
+            pthread_mutex_lock(&r->mu);
+            r->readIdx = (r->readIdx + 1) % r->buffersLen;
+            r->filled--;
+            pthread_cond_signal(&r->notFull);
+            pthread_mutex_unlock(&r->mu);
+            r->wordPos = 0;
+        }
+    }
+    return n;
+}
+
+void simple8bReaderClose(struct simple8bReader* r) {
+    pthread_mutex_lock(&r->mu);
+    r->stop = true;
+    pthread_cond_broadcast(&r->notFull);
+    pthread_mutex_unlock(&r->mu);
+    pthread_join(r->thread, NULL);
+    release(r);
+}
@@ -0,0 +1,52 @@
+// simple8b_reader.h implements a streaming decoder for simple8b words stored in a file.
+// A dedicated I/O thread reads the next chunks of words into a ring of aligned buffers
+// while the caller decodes the current one, so that reading and decoding overlap. The
+// I/O thread blocks once every buffer is filled, until the caller catches up.
+// Words are stored in native byte order.
+
+#pragma once
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+struct simple8bReader {
+    int fd;
+    off_t offset;  // next byte read by the I/O thread
+    off_t end;     // end of the encoded words in the file
+    int chunkWords;
+
+    uint64_t** buffers;
+    int* lens;  // number of words held by each buffer
+    int buffersLen;
+    int readIdx;   // buffer being decoded by the caller
+    int writeIdx;  // buffer being filled by the I/O thread
+    int filled;    // buffers handed to the caller and not released yet
+    bool done;     // the I/O thread has nothing more to read
+    bool stop;
+    int err;  // errno of a failed read, 0 otherwise
+
+    pthread_mutex_t mu;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_t thread;
+
+    int wordPos;  // next word to decode in buffers[readIdx]
+    uint64_t pending[240];  // values decoded but not returned yet
+    int pendingLen;
+    int pendingPos;
+};
+
+// `simple8bReaderOpen()` starts reading `wordsLen` words at byte `offset` of `fd`, in chunks of
+// `chunkWords` words, with up to `buffersLen` chunks read ahead. It returns false when memory
+// or the I/O thread cannot be allocated.
+bool simple8bReaderOpen(struct simple8bReader* r, int fd, off_t offset, uint64_t wordsLen, int chunkWords,
+                        int buffersLen);
+
+// `simple8bReaderNext()` decodes up to `dstCap` values into `dst` and returns the number of values
+// written. It blocks until `dst` is full or the words are exhausted, and returns 0 at the end of the
+// words or -1 when a read failed.
+int simple8bReaderNext(struct simple8bReader* r, uint64_t* restrict dst, int dstCap);
+
+// `simple8bReaderClose()` stops the I/O thread and releases the buffers. It does not close `fd`.
+void simple8bReaderClose(struct simple8bReader* r);
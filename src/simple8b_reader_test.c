@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./simple8b_reader.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "./simple8b.h"
+
+// writeColumn encodes n values into a temporary file, prefixed by `headerBytes` bytes,
+// and returns its descriptor. `wordsLen` receives the number of words written.
+int writeColumn(const uint64_t* in, int n, int headerBytes, uint64_t* wordsLen) {
+    char path[] = "/tmp/simple8b_reader_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+
+    char header[64] = {0};
+    assert(headerBytes <= (int)sizeof(header));
+    assert(write(fd, header, headerBytes) == headerBytes);
+
+    *wordsLen = 0;
+    for (int i = 0; i < n;) {
+        uint64_t encoded;
+        i += simple8bEncode(in + i, n - i, &encoded);
+        assert(write(fd, &encoded, sizeof(encoded)) == sizeof(encoded));
+        (*wordsLen)++;
+    }
+    return fd;
+}
+
+void testReader(int n, int chunkWords, int buffersLen, int batch) {
+    uint64_t* in = malloc(sizeof(uint64_t) * n);
+    uint64_t* out = malloc(sizeof(uint64_t) * batch);
+    assert(in && out);
+    for (int i = 0; i < n; i++) {
+        in[i] = (i / 500) % 3 == 0 ? 1 : (uint64_t)i * 7919 % 100000;
+    }
+    uint64_t wordsLen;
+    int fd = writeColumn(in, n, 24, &wordsLen);
+
+    struct simple8bReader r;
+    assert(simple8bReaderOpen(&r, fd, 24, wordsLen, chunkWords, buffersLen));
+    int k = 0;
+    int m;
+    while ((m = simple8bReaderNext(&r, out, batch)) > 0) {
+        for (int i = 0; i < m; i++) {
+            assert(k + i < n);
+            assert(out[i] == in[k + i]);
+        }
+        k += m;
+    }
+    assert(m == 0);
+    assert(k == n);
+    simple8bReaderClose(&r);
+    close(fd);
+    free(in);
+    free(out);
+}
+
+void testReaderShortFile() {
+    uint64_t in[100];
+    for (int i = 0; i < 100; i++) {
+        in[i] = i;
+    }
+    uint64_t wordsLen;
+    int fd = writeColumn(in, 100, 0, &wordsLen);
+
+    struct simple8bReader r;
+    assert(simple8bReaderOpen(&r, fd, 0, wordsLen + 10, 1, 2));
+    uint64_t out[1000];
+    assert(simple8bReaderNext(&r, out, 1000) == 100);
+    assert(simple8bReaderNext(&r, out, 1000) == -1);
+    simple8bReaderClose(&r);
+    close(fd);
+}
+
+void testReaderEarlyClose() {
+    uint64_t in[10000];
+    for (int i = 0; i < 10000; i++) {
+        in[i] = i;
+    }
+    uint64_t wordsLen;
+    int fd = writeColumn(in, 10000, 0, &wordsLen);
+
+    struct simple8bReader r;
+    assert(simple8bReaderOpen(&r, fd, 0, wordsLen, 8, 2));
+    uint64_t out[10];
+    assert(simple8bReaderNext(&r, out, 10) == 10);
+    simple8bReaderClose(&r);
+    close(fd);
+}
+
+int main() {
+    testReader(100000, 512, 4, 4096);
+    printf("Pass testReader(100000, 512, 4, 4096)\n");
+    testReader(100000, 3, 2, 100);
+    printf("Pass testReader(100000, 3, 2, 100)\n");
+    testReader(5000, 1, 1, 1);
+    printf("Pass testReader(5000, 1, 1, 1)\n");
+    testReader(1, 64, 2, 240);
+    printf("Pass testReader(1, 64, 2, 240)\n");
+    testReaderShortFile();
+    printf("Pass testReaderShortFile()\n");
+    testReaderEarlyClose();
+    printf("Pass testReaderEarlyClose()\n");
+    return 0;
+}
@@ -45,6 +45,91 @@ void testEncode(int n, uint64_t val) {
     }
 }
 
+// encodeAll encodes n values of `in` into `encoded` and returns the number of words.
+int encodeAll(const uint64_t* in, int n, uint64_t* encoded) {
+    int encodedLen = 0;
+    for (int i = 0; i < n;) {
+        i += simple8bEncode(in + i, n - i, encoded + encodedLen);
+        encodedLen++;
+    }
+    return encodedLen;
+}
+
+// decodeAll decodes `encodedLen` words into `out` and returns the number of values.
+int decodeAll(const uint64_t* encoded, int encodedLen, uint64_t* out) {
+    int k = 0;
+    for (int i = 0; i < encodedLen; i++) {
+        k += simple8bDecode(out + k, encoded[i]);
+    }
+    return k;
+}
+
+void testConcat(int aLen, uint64_t aVal, int bLen, uint64_t bVal, int wantWords) {
+    uint64_t* in = malloc(sizeof(uint64_t) * (aLen + bLen));
+    assert(in);
+    for (int i = 0; i < aLen; i++) {
+        in[i] = aVal;
+    }
+    for (int i = 0; i < bLen; i++) {
+        in[aLen + i] = bVal;
+    }
+
+    uint64_t* a = malloc(sizeof(uint64_t) * (aLen + 1));
+    uint64_t* b = malloc(sizeof(uint64_t) * (bLen + 1));
+    uint64_t* dst = malloc(sizeof(uint64_t) * (aLen + bLen + 2));
+    uint64_t* out = malloc(sizeof(uint64_t) * (aLen + bLen + 240));
+    assert(a && b && dst && out);
+    int na = encodeAll(in, aLen, a);
+    int nb = encodeAll(in + aLen, bLen, b);
+
+    assert(wantWords == 0 || simple8bConcat(a, na, b, nb, dst, wantWords - 1) == -1);
+    int n = simple8bConcat(a, na, b, nb, dst, wantWords);
+    assert(n == wantWords);
+    assert(simple8bCount(dst, n) == aLen + bLen);
+    assert(decodeAll(dst, n, out) == aLen + bLen);
+    for (int i = 0; i < aLen + bLen; i++) {
+        assert(out[i] == in[i]);
+    }
+    free(in);
+    free(a);
+    free(b);
+    free(dst);
+    free(out);
+}
+
+void testSlice(int n) {
+    uint64_t* in = malloc(sizeof(uint64_t) * n);
+    uint64_t* encoded = malloc(sizeof(uint64_t) * n);
+    uint64_t* dst = malloc(sizeof(uint64_t) * n);
+    uint64_t* out = malloc(sizeof(uint64_t) * (n + 240));
+    assert(in && encoded && dst && out);
+    for (int i = 0; i < n; i++) {
+        // runs of ones mixed with values of growing width
+        in[i] = (i / 300) % 2 ? 1 : (uint64_t)i * i % 5000;
+    }
+    int encodedLen = encodeAll(in, n, encoded);
+
+    for (int start = 0; start < n; start += 37) {
+        for (int len = 0; start + len <= n + 50; len += 53) {
+            int words = simple8bSlice(encoded, encodedLen, start, len, dst, n);
+            assert(words >= 0);
+            int want = start + len <= n ? len : n - start;
+            assert(decodeAll(dst, words, out) == want);
+            for (int i = 0; i < want; i++) {
+                assert(out[i] == in[start + i]);
+            }
+        }
+    }
+    assert(simple8bSlice(encoded, encodedLen, 1, n, dst, 1) == -1);
+    assert(simple8bSlice(encoded, encodedLen, -1, 10, dst, n) == -1);
+    assert(simple8bSlice(encoded, encodedLen, 0, -1, dst, n) == -1);
+    assert(simple8bConcat(encoded, -1, encoded, 1, dst, n) == -1);
+    free(in);
+    free(encoded);
+    free(dst);
+    free(out);
+}
+
 int main() {
     testEncodeNoValues();
     printf("Pass testEncodeNoValues()\n");
@@ -88,5 +173,19 @@ int main() {
     printf("Pass testEncode(2, 1073741823)\n");
     testEncode(1, 1152921504606846975);
     printf("Pass testEncode(1, 1152921504606846975)\n");
+    testConcat(1, 3, 1, 5, 1);
+    printf("Pass testConcat(1, 3, 1, 5, 1)\n");
+    testConcat(100, 7, 100, 9, 12);
+    printf("Pass testConcat(100, 7, 100, 9, 12)\n");
+    testConcat(2, 1000, 1, 1000, 1);
+    printf("Pass testConcat(2, 1000, 1, 1000, 1)\n");
+    testConcat(240, 1, 240, 1, 2);
+    printf("Pass testConcat(240, 1, 240, 1, 2)\n");
+    testConcat(0, 0, 10, 1023, 2);
+    printf("Pass testConcat(0, 0, 10, 1023, 2)\n");
+    testConcat(3, 1048575, 0, 0, 1);
+    printf("Pass testConcat(3, 1048575, 0, 0, 1)\n");
+    testSlice(2000);
+    printf("Pass testSlice(2000)\n");
     return 0;
 }
\ No newline at end of file